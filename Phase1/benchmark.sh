@@ -7,6 +7,7 @@ set -e
 # Configuration
 SIZES=(512 1024 2048)
 THREADS=(1 2 4 8)
+TILE_SIZES=("32 128" "64 256" "128 512")
 NUM_RUNS=5
 OUTPUT_CSV="benchmark_results.csv"
 
@@ -21,8 +22,14 @@ if [ ! -f "./edge_sobel_seq" ] || [ ! -f "./edge_sobel_omp" ]; then
     exit 1
 fi
 
+# Correctness gate: every registered kernel must match the sequential golden
+# reference before any timing numbers are recorded
+echo "Verifying kernels against the sequential reference..."
+./edge_sobel_omp verify || { echo "Error: kernel verification failed."; exit 1; }
+echo ""
+
 # Create CSV header
-echo "IMAGE_SIZE,MODE,THREADS,AVG_TIME_MS,MIN_TIME_MS,MAX_TIME_MS,GFLOPS" > "$OUTPUT_CSV"
+echo "IMAGE_SIZE,MODE,THREADS,TILE,AVG_TIME_MS,MIN_TIME_MS,MAX_TIME_MS,GFLOPS,XFER_MS,SKIP" > "$OUTPUT_CSV"
 
 # Benchmark loop
 echo "Running benchmarks (this may take several minutes)..."
@@ -42,7 +49,7 @@ for size in "${SIZES[@]}"; do
     max_time=$(echo "$result" | grep -oP '(?<=MAX=)\d+\.\d+' || echo "0")
     gflops=$(echo "$result" | grep -oP '(?<=GFLOPS=)\d+\.\d+' || echo "0")
     
-    echo "$size,SEQ,1,$avg_time,$min_time,$max_time,$gflops" >> "$OUTPUT_CSV"
+    echo "$size,SEQ,1,,$avg_time,$min_time,$max_time,$gflops,," >> "$OUTPUT_CSV"
     
     # OpenMP parallel tests
     for thread_count in "${THREADS[@]}"; do
@@ -56,8 +63,85 @@ for size in "${SIZES[@]}"; do
         max_time=$(echo "$result" | grep -oP '(?<=MAX=)\d+\.\d+' || echo "0")
         gflops=$(echo "$result" | grep -oP '(?<=GFLOPS=)\d+\.\d+' || echo "0")
         
-        echo "$size,OMP,$thread_count,$avg_time,$min_time,$max_time,$gflops" >> "$OUTPUT_CSV"
+        echo "$size,OMP,$thread_count,,$avg_time,$min_time,$max_time,$gflops,," >> "$OUTPUT_CSV"
+    done
+
+    # Separable-filter variant: same thread sweep so it lines up against the
+    # direct stencil at every N
+    for thread_count in "${THREADS[@]}"; do
+        echo -n "  Separable ($thread_count threads): "
+        result=$(./edge_sobel_omp sep "$size" "$thread_count" "$NUM_RUNS")
+        echo "$result" | grep -o "AVG_TIME=[0-9.]*" | cut -d= -f2
+
+        avg_time=$(echo "$result" | grep -oP '(?<=AVG_TIME=)\d+\.\d+' || echo "0")
+        min_time=$(echo "$result" | grep -oP '(?<=MIN=)\d+\.\d+' || echo "0")
+        max_time=$(echo "$result" | grep -oP '(?<=MAX=)\d+\.\d+' || echo "0")
+        gflops=$(echo "$result" | grep -oP '(?<=GFLOPS=)\d+\.\d+' || echo "0")
+
+        echo "$size,SEP,$thread_count,,$avg_time,$min_time,$max_time,$gflops,," >> "$OUTPUT_CSV"
+    done
+
+    # Cache-blocked (tiled) tests: sweep tile sizes so analyze_performance.py
+    # can plot miss rate / runtime vs tile footprint
+    for tile in "${TILE_SIZES[@]}"; do
+        read -r tile_rows tile_cols <<< "$tile"
+        echo -n "  Tiled (${tile_rows}x${tile_cols}, 4 threads): "
+        result=$(./edge_sobel_omp tiled "$size" 4 "$NUM_RUNS" "$tile_rows" "$tile_cols")
+        echo "$result" | grep -o "AVG_TIME=[0-9.]*" | cut -d= -f2
+
+        avg_time=$(echo "$result" | grep -oP '(?<=AVG_TIME=)\d+\.\d+' || echo "0")
+        min_time=$(echo "$result" | grep -oP '(?<=MIN=)\d+\.\d+' || echo "0")
+        max_time=$(echo "$result" | grep -oP '(?<=MAX=)\d+\.\d+' || echo "0")
+        gflops=$(echo "$result" | grep -oP '(?<=GFLOPS=)\d+\.\d+' || echo "0")
+
+        echo "$size,TILED,4,${tile_rows}x${tile_cols},$avg_time,$min_time,$max_time,$gflops,," >> "$OUTPUT_CSV"
+    done
+
+    # Magnitude-policy variants: same kernel as OMP with approximate norms,
+    # one row each so the accuracy/throughput trade-off is quantifiable
+    for norm in l1 maxmin sqthresh; do
+        norm_upper=$(echo "$norm" | tr '[:lower:]' '[:upper:]')
+        echo -n "  Norm $norm (4 threads): "
+        result=$(./edge_sobel_omp "$norm" "$size" 4 "$NUM_RUNS")
+        echo "$result" | grep -o "AVG_TIME=[0-9.]*" | cut -d= -f2
+
+        avg_time=$(echo "$result" | grep -oP '(?<=AVG_TIME=)\d+\.\d+' || echo "0")
+        min_time=$(echo "$result" | grep -oP '(?<=MIN=)\d+\.\d+' || echo "0")
+        max_time=$(echo "$result" | grep -oP '(?<=MAX=)\d+\.\d+' || echo "0")
+        gflops=$(echo "$result" | grep -oP '(?<=GFLOPS=)\d+\.\d+' || echo "0")
+
+        echo "$size,$norm_upper,4,,$avg_time,$min_time,$max_time,$gflops,," >> "$OUTPUT_CSV"
     done
+
+    # Pyramid early-exit rows: SKIP is the fraction of tiles the coarse level
+    # let us skip, the quantity that justifies the approximation
+    echo -n "  Pyramid (4 threads): "
+    result=$(./edge_sobel_omp pyramid "$size" 4 "$NUM_RUNS")
+    echo "$result" | grep -o "AVG_TIME=[0-9.]*" | cut -d= -f2
+
+    avg_time=$(echo "$result" | grep -oP '(?<=AVG_TIME=)\d+\.\d+' || echo "0")
+    min_time=$(echo "$result" | grep -oP '(?<=MIN=)\d+\.\d+' || echo "0")
+    max_time=$(echo "$result" | grep -oP '(?<=MAX=)\d+\.\d+' || echo "0")
+    gflops=$(echo "$result" | grep -oP '(?<=GFLOPS=)\d+\.\d+' || echo "0")
+    skip=$(echo "$result" | grep -oP '(?<=SKIP=)\d+\.\d+' || echo "0")
+
+    echo "$size,PYRAMID,4,,$avg_time,$min_time,$max_time,$gflops,,$skip" >> "$OUTPUT_CSV"
+
+    # GPU offload rows (only when the offload binary was built with 'make gpu');
+    # XFER_MS separates PCIe transfer cost from kernel cost
+    if [ -f "./edge_sobel_gpu" ]; then
+        echo -n "  GPU offload: "
+        result=$(./edge_sobel_gpu gpu "$size" 4 "$NUM_RUNS")
+        echo "$result" | grep -o "AVG_TIME=[0-9.]*" | cut -d= -f2
+
+        avg_time=$(echo "$result" | grep -oP '(?<=AVG_TIME=)\d+\.\d+' || echo "0")
+        min_time=$(echo "$result" | grep -oP '(?<=MIN=)\d+\.\d+' || echo "0")
+        max_time=$(echo "$result" | grep -oP '(?<=MAX=)\d+\.\d+' || echo "0")
+        gflops=$(echo "$result" | grep -oP '(?<=GFLOPS=)\d+\.\d+' || echo "0")
+        xfer=$(echo "$result" | grep -oP '(?<=XFER_MS=)\d+\.\d+' || echo "0")
+
+        echo "$size,GPU,4,,$avg_time,$min_time,$max_time,$gflops,$xfer," >> "$OUTPUT_CSV"
+    fi
     echo ""
 done
 
@@ -0,0 +1,104 @@
+// libsobel - the Phase 1 Sobel kernels behind a stable C API
+//
+// Mirrors run_sobel_seq / run_sobel_omp / run_sobel_tiled from
+// edge_detiction.cpp, generalized from square N x N test images to the
+// rows x cols buffers the Phase III server handles, and stripped of the
+// benchmark timing harness. Compile with -shared -fPIC (see 'make lib').
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "libsobel.h"
+
+using namespace std;
+
+static inline int clamp255(int v) { return v < 0 ? 0 : (v > 255 ? 255 : v); }
+
+// One output pixel of the 3x3 Sobel stencil; uint8_t operands widen to int
+// before the arithmetic
+static inline uint8_t sobel_pixel(const uint8_t *img, int cols, int i, int j) {
+    int Gx = -(int)img[(i-1)*cols + (j-1)] - 2*(int)img[i*cols + (j-1)] - (int)img[(i+1)*cols + (j-1)]
+             + (int)img[(i-1)*cols + (j+1)] + 2*(int)img[i*cols + (j+1)] + (int)img[(i+1)*cols + (j+1)];
+    int Gy = -(int)img[(i-1)*cols + (j-1)] - 2*(int)img[(i-1)*cols + j]   - (int)img[(i-1)*cols + (j+1)]
+             + (int)img[(i+1)*cols + (j-1)] + 2*(int)img[(i+1)*cols + j]   + (int)img[(i+1)*cols + (j+1)];
+    int val = (int)sqrt((double)Gx*Gx + (double)Gy*Gy);
+    return (uint8_t)clamp255(val);
+}
+
+// The one-pixel frame the stencil can't reach is defined as 0
+static void zero_borders(uint8_t *out, int rows, int cols) {
+    memset(out, 0, cols);
+    memset(&out[(rows-1) * cols], 0, cols);
+    for (int i = 1; i < rows-1; ++i) {
+        out[i * cols] = 0;
+        out[i * cols + cols - 1] = 0;
+    }
+}
+
+static void sobel_seq(const uint8_t *img, uint8_t *out, int rows, int cols) {
+    for (int i = 1; i < rows-1; ++i)
+        for (int j = 1; j < cols-1; ++j)
+            out[i*cols + j] = sobel_pixel(img, cols, i, j);
+}
+
+static void sobel_omp(const uint8_t *img, uint8_t *out, int rows, int cols) {
+    #ifdef _OPENMP
+    #pragma omp parallel for collapse(2) schedule(static)
+    #endif
+    for (int i = 1; i < rows-1; ++i)
+        for (int j = 1; j < cols-1; ++j)
+            out[i*cols + j] = sobel_pixel(img, cols, i, j);
+}
+
+// Cache-blocked variant, same tile shape as the Phase 1 'tiled' mode default
+static void sobel_tiled(const uint8_t *img, uint8_t *out, int rows, int cols) {
+    const int tile_rows = 64, tile_cols = 256;
+    #ifdef _OPENMP
+    #pragma omp parallel for collapse(2) schedule(static)
+    #endif
+    for (int ti = 1; ti < rows-1; ti += tile_rows)
+        for (int tj = 1; tj < cols-1; tj += tile_cols) {
+            int i_end = min(ti + tile_rows, rows-1);
+            int j_end = min(tj + tile_cols, cols-1);
+            for (int i = ti; i < i_end; ++i)
+                for (int j = tj; j < j_end; ++j)
+                    out[i*cols + j] = sobel_pixel(img, cols, i, j);
+        }
+}
+
+extern "C" int sobel_process(const unsigned char *input, unsigned char *output,
+                             int rows, int cols, const char *variant,
+                             int threads) {
+    if (!input || !output || rows < 3 || cols < 3)
+        return -1;
+    if (!variant)
+        variant = "omp";
+
+    #ifdef _OPENMP
+    if (threads > 0)
+        omp_set_num_threads(threads);
+    #else
+    (void)threads;
+    #endif
+
+    zero_borders(output, rows, cols);
+
+    if (strcmp(variant, "seq") == 0)
+        sobel_seq(input, output, rows, cols);
+    else if (strcmp(variant, "omp") == 0)
+        sobel_omp(input, output, rows, cols);
+    else if (strcmp(variant, "tiled") == 0)
+        sobel_tiled(input, output, rows, cols);
+    else
+        return -2;
+    return 0;
+}
+
+extern "C" const char *sobel_variants(void) {
+    return "seq,omp,tiled";
+}
@@ -0,0 +1,43 @@
+/*
+ * libsobel - stable C API around the Phase 1 Sobel kernels
+ *
+ * All functions operate on caller-owned buffers: input is a rows x cols
+ * row-major grayscale image (one byte per pixel), output is a caller-
+ * allocated buffer of the same shape. Nothing is copied or retained, so
+ * callers like the Phase III Python worker can pass numpy array memory
+ * through ctypes with zero copies.
+ *
+ * Border convention matches the Phase 1 binaries: the one-pixel frame where
+ * the 3x3 stencil would read out of bounds is written as 0.
+ */
+#ifndef LIBSOBEL_H
+#define LIBSOBEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Run Sobel edge detection.
+ *
+ *   input    rows*cols bytes, row-major grayscale
+ *   output   rows*cols bytes, caller-allocated
+ *   rows     image height (>= 3)
+ *   cols     image width  (>= 3)
+ *   variant  "seq", "omp" or "tiled"; NULL selects "omp"
+ *   threads  OpenMP thread count for parallel variants; <= 0 keeps the
+ *            runtime default
+ *
+ * Returns 0 on success, -1 on bad arguments, -2 on unknown variant.
+ */
+int sobel_process(const unsigned char *input, unsigned char *output,
+                  int rows, int cols, const char *variant, int threads);
+
+/* Comma-separated list of variants this build supports */
+const char *sobel_variants(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBSOBEL_H */
@@ -163,6 +163,46 @@ def analyze_latency_bandwidth():
     plt.savefig('plots/latency_bandwidth.png', dpi=300, bbox_inches='tight')
     print("✓ Saved: plots/latency_bandwidth.png")
 
+def analyze_halo_benchmark():
+    """Analyze halo-exchange microbenchmark results"""
+    if not os.path.exists('halo_benchmark_results.csv'):
+        print("Warning: halo_benchmark_results.csv not found")
+        return
+
+    df = pd.read_csv('halo_benchmark_results.csv')
+    if df.empty:
+        return
+
+    fig, (ax1, ax2) = plt.subplots(1, 2, figsize=(14, 5))
+
+    # Plot 1: Exchange time vs image size, one line per pattern
+    for pattern in df['PATTERN'].unique():
+        pattern_data = df[df['PATTERN'] == pattern].sort_values('IMAGE_SIZE')
+        ax1.loglog(pattern_data['IMAGE_SIZE'], pattern_data['AVG_TIME_US'],
+                  marker='o', linewidth=2, markersize=8, label=pattern)
+
+    ax1.set_xlabel('Image Size (N x N)', fontsize=11, fontweight='bold')
+    ax1.set_ylabel('Halo Exchange Time (μs)', fontsize=11, fontweight='bold')
+    ax1.set_title('Halo Exchange Cost vs Problem Size', fontsize=12, fontweight='bold')
+    ax1.grid(True, alpha=0.3, which='both')
+    ax1.legend(fontsize=10)
+
+    # Plot 2: Effective bandwidth per pattern
+    for pattern in df['PATTERN'].unique():
+        pattern_data = df[df['PATTERN'] == pattern].sort_values('IMAGE_SIZE')
+        ax2.semilogx(pattern_data['IMAGE_SIZE'], pattern_data['BANDWIDTH_MBS'],
+                    marker='s', linewidth=2, markersize=8, label=pattern)
+
+    ax2.set_xlabel('Image Size (N x N)', fontsize=11, fontweight='bold')
+    ax2.set_ylabel('Effective Bandwidth (MB/s)', fontsize=11, fontweight='bold')
+    ax2.set_title('Halo Exchange Bandwidth', fontsize=12, fontweight='bold')
+    ax2.grid(True, alpha=0.3, which='both')
+    ax2.legend(fontsize=10)
+
+    plt.tight_layout()
+    plt.savefig('plots/halo_benchmark.png', dpi=300, bbox_inches='tight')
+    print("✓ Saved: plots/halo_benchmark.png")
+
 def print_analysis_summary():
     """Print summary of analysis"""
     print("\n" + "="*80)
@@ -203,7 +243,8 @@ def main():
         plot_weak_scaling(weak_df)
     
     analyze_latency_bandwidth()
-    
+    analyze_halo_benchmark()
+
     print_analysis_summary()
     
     print("\n✓ Analysis complete! Check plots/ directory for visualizations.")
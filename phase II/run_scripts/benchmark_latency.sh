@@ -21,8 +21,15 @@ echo ""
 
 mpirun -np 2 ./src/benchmark_latency | tee latency_bandwidth_results.txt
 
+echo ""
+echo "Running halo-exchange benchmark suite (4 processes)..."
+echo ""
+
+mpirun -np 4 ./src/benchmark_latency halo
+
 echo ""
 echo "Results saved to: latency_bandwidth_results.txt"
+echo "                  halo_benchmark_results.csv"
 echo ""
 echo "Key Metrics:"
 echo "  - Latency: One-way message latency (lower is better)"
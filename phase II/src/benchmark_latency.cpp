@@ -1,7 +1,10 @@
 #include <iostream>
+#include <fstream>
 #include <vector>
+#include <string>
 #include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <iomanip>
 #include <mpi.h>
 
@@ -52,6 +55,234 @@ LatencyBandwidth measure_pair(int rank, int peer_rank, int message_size, int ite
     return result;
 }
 
+// ============================================================
+// Halo-exchange-shaped suite
+// ============================================================
+// Raw ping-pong numbers don't predict the Sobel runtime: the real pattern is
+// four simultaneous neighbor exchanges, two of them strided column data. The
+// suite below times exactly the communication shapes exchange_halo_blocking
+// produces for a given N and rank count, so strong-scaling limits can be
+// estimated from the measurements alone.
+
+// 2D grid decomposition - mirrors setup_domain() in sobel_mpi.cpp so the
+// message sizes here match the real halo exchange byte for byte
+struct HaloGeometry {
+    int grid_rows, grid_cols;
+    int my_row, my_col;
+    int local_rows, local_cols;
+    int north, south, west, east;  // world ranks or MPI_PROC_NULL
+};
+
+HaloGeometry setup_geometry(int image_size, int rank, int world_size) {
+    HaloGeometry g;
+    int grid_dim = (int)sqrt(world_size);
+    while (world_size % grid_dim != 0) grid_dim--;
+
+    g.grid_rows = grid_dim;
+    g.grid_cols = world_size / grid_dim;
+    g.my_row = rank / g.grid_cols;
+    g.my_col = rank % g.grid_cols;
+
+    g.local_rows = image_size / g.grid_rows;
+    g.local_cols = image_size / g.grid_cols;
+    if (g.my_row == g.grid_rows - 1)
+        g.local_rows = image_size - (g.grid_rows - 1) * g.local_rows;
+    if (g.my_col == g.grid_cols - 1)
+        g.local_cols = image_size - (g.grid_cols - 1) * g.local_cols;
+
+    g.north = (g.my_row > 0) ? rank - g.grid_cols : MPI_PROC_NULL;
+    g.south = (g.my_row < g.grid_rows - 1) ? rank + g.grid_cols : MPI_PROC_NULL;
+    g.west  = (g.my_col > 0) ? rank - 1 : MPI_PROC_NULL;
+    g.east  = (g.my_col < g.grid_cols - 1) ? rank + 1 : MPI_PROC_NULL;
+    return g;
+}
+
+// One full halo exchange on the haloed buffer. 'strided' sends the east/west
+// columns through a vector type as the Sobel code does; otherwise the columns
+// are packed into contiguous scratch buffers first. 'nonblocking' posts all
+// transfers as Irecv/Isend and waits once.
+void run_halo_exchange(vector<uint8_t>& img, const HaloGeometry& g,
+                       bool strided, bool nonblocking,
+                       vector<uint8_t>& scratch) {
+    int rows = g.local_rows;
+    int cols = g.local_cols;
+    int pitch = cols + 2;
+
+    MPI_Datatype col_type = MPI_DATATYPE_NULL;
+    if (strided) {
+        MPI_Type_vector(rows, 1, pitch, MPI_UINT8_T, &col_type);
+        MPI_Type_commit(&col_type);
+    } else {
+        // Pack layout: [west send][east send][west recv][east recv]
+        for (int i = 0; i < rows; ++i) {
+            scratch[i] = img[(i+1) * pitch + 1];
+            scratch[rows + i] = img[(i+1) * pitch + cols];
+        }
+    }
+
+    if (nonblocking) {
+        MPI_Request reqs[8];
+        int count = 0;
+        if (g.north != MPI_PROC_NULL) {
+            MPI_Irecv(&img[1], cols, MPI_UINT8_T, g.north, 1,
+                      MPI_COMM_WORLD, &reqs[count++]);
+            MPI_Isend(&img[pitch + 1], cols, MPI_UINT8_T, g.north, 0,
+                      MPI_COMM_WORLD, &reqs[count++]);
+        }
+        if (g.south != MPI_PROC_NULL) {
+            MPI_Irecv(&img[(rows+1) * pitch + 1], cols, MPI_UINT8_T, g.south, 0,
+                      MPI_COMM_WORLD, &reqs[count++]);
+            MPI_Isend(&img[rows * pitch + 1], cols, MPI_UINT8_T, g.south, 1,
+                      MPI_COMM_WORLD, &reqs[count++]);
+        }
+        if (g.west != MPI_PROC_NULL) {
+            if (strided) {
+                MPI_Irecv(&img[pitch], 1, col_type, g.west, 3,
+                          MPI_COMM_WORLD, &reqs[count++]);
+                MPI_Isend(&img[pitch + 1], 1, col_type, g.west, 2,
+                          MPI_COMM_WORLD, &reqs[count++]);
+            } else {
+                MPI_Irecv(&scratch[2*rows], rows, MPI_UINT8_T, g.west, 3,
+                          MPI_COMM_WORLD, &reqs[count++]);
+                MPI_Isend(&scratch[0], rows, MPI_UINT8_T, g.west, 2,
+                          MPI_COMM_WORLD, &reqs[count++]);
+            }
+        }
+        if (g.east != MPI_PROC_NULL) {
+            if (strided) {
+                MPI_Irecv(&img[pitch + cols + 1], 1, col_type, g.east, 2,
+                          MPI_COMM_WORLD, &reqs[count++]);
+                MPI_Isend(&img[pitch + cols], 1, col_type, g.east, 3,
+                          MPI_COMM_WORLD, &reqs[count++]);
+            } else {
+                MPI_Irecv(&scratch[3*rows], rows, MPI_UINT8_T, g.east, 2,
+                          MPI_COMM_WORLD, &reqs[count++]);
+                MPI_Isend(&scratch[rows], rows, MPI_UINT8_T, g.east, 3,
+                          MPI_COMM_WORLD, &reqs[count++]);
+            }
+        }
+        MPI_Waitall(count, reqs, MPI_STATUSES_IGNORE);
+    } else {
+        if (g.north != MPI_PROC_NULL)
+            MPI_Sendrecv(&img[pitch + 1], cols, MPI_UINT8_T, g.north, 0,
+                         &img[1], cols, MPI_UINT8_T, g.north, 1,
+                         MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        if (g.south != MPI_PROC_NULL)
+            MPI_Sendrecv(&img[rows * pitch + 1], cols, MPI_UINT8_T, g.south, 1,
+                         &img[(rows+1) * pitch + 1], cols, MPI_UINT8_T, g.south, 0,
+                         MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        if (g.west != MPI_PROC_NULL) {
+            if (strided)
+                MPI_Sendrecv(&img[pitch + 1], 1, col_type, g.west, 2,
+                             &img[pitch], 1, col_type, g.west, 3,
+                             MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            else
+                MPI_Sendrecv(&scratch[0], rows, MPI_UINT8_T, g.west, 2,
+                             &scratch[2*rows], rows, MPI_UINT8_T, g.west, 3,
+                             MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        }
+        if (g.east != MPI_PROC_NULL) {
+            if (strided)
+                MPI_Sendrecv(&img[pitch + cols], 1, col_type, g.east, 3,
+                             &img[pitch + cols + 1], 1, col_type, g.east, 2,
+                             MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            else
+                MPI_Sendrecv(&scratch[rows], rows, MPI_UINT8_T, g.east, 3,
+                             &scratch[3*rows], rows, MPI_UINT8_T, g.east, 2,
+                             MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        }
+    }
+
+    if (!strided) {
+        // Unpack received columns into the halo, like a real packed exchange
+        for (int i = 0; i < rows; ++i) {
+            if (g.west != MPI_PROC_NULL) img[(i+1) * pitch] = scratch[2*rows + i];
+            if (g.east != MPI_PROC_NULL)
+                img[(i+1) * pitch + cols + 1] = scratch[3*rows + i];
+        }
+    }
+
+    if (col_type != MPI_DATATYPE_NULL)
+        MPI_Type_free(&col_type);
+}
+
+// Time one exchange variant: warmup, then iterations bracketed by barriers.
+// Returns the max per-exchange time across ranks (the one that gates compute).
+double time_halo_variant(vector<uint8_t>& img, const HaloGeometry& g,
+                         bool strided, bool nonblocking, int iterations) {
+    vector<uint8_t> scratch(4 * (size_t)g.local_rows, 0);
+
+    for (int i = 0; i < 5; ++i)
+        run_halo_exchange(img, g, strided, nonblocking, scratch);
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    double start = MPI_Wtime();
+    for (int i = 0; i < iterations; ++i)
+        run_halo_exchange(img, g, strided, nonblocking, scratch);
+    double local_us = (MPI_Wtime() - start) / iterations * 1e6;
+
+    double max_us;
+    MPI_Reduce(&local_us, &max_us, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+    return max_us;
+}
+
+void run_halo_suite(int rank, int world_size, const vector<int>& image_sizes) {
+    ofstream csv;
+    if (rank == 0) {
+        csv.open("halo_benchmark_results.csv");
+        csv << "IMAGE_SIZE,PROCESSES,PATTERN,MSG_BYTES,AVG_TIME_US,BANDWIDTH_MBS\n";
+        cout << "Halo Exchange Benchmark Suite\n";
+        cout << "=============================\n";
+        cout << "World size: " << world_size << "\n\n";
+        cout << fixed << setprecision(3);
+        cout << "N\tPattern\t\t\tBytes/exch\tTime (μs)\tBW (MB/s)\n";
+        cout << "=================================================================\n";
+    }
+
+    struct Variant { const char* name; bool strided, nonblocking; };
+    const Variant variants[] = {
+        {"blocking_packed",      false, false},
+        {"blocking_strided",     true,  false},
+        {"nonblocking_packed",   false, true},
+        {"nonblocking_strided",  true,  true},
+    };
+
+    for (int N : image_sizes) {
+        HaloGeometry g = setup_geometry(N, rank, world_size);
+        vector<uint8_t> img((size_t)(g.local_rows + 2) * (g.local_cols + 2), 0);
+
+        // Bytes this rank moves per exchange (sends only; recvs mirror them)
+        long local_bytes = 0;
+        if (g.north != MPI_PROC_NULL) local_bytes += g.local_cols;
+        if (g.south != MPI_PROC_NULL) local_bytes += g.local_cols;
+        if (g.west != MPI_PROC_NULL) local_bytes += g.local_rows;
+        if (g.east != MPI_PROC_NULL) local_bytes += g.local_rows;
+        long max_bytes;
+        MPI_Reduce(&local_bytes, &max_bytes, 1, MPI_LONG, MPI_MAX, 0,
+                   MPI_COMM_WORLD);
+
+        int iterations = (N <= 1024) ? 1000 : 200;
+        for (const Variant& v : variants) {
+            double us = time_halo_variant(img, g, v.strided, v.nonblocking,
+                                          iterations);
+            if (rank == 0) {
+                double bw = (us > 0) ? (max_bytes / (us / 1e6)) / 1e6 : 0;
+                cout << N << "\t" << left << setw(20) << v.name << right
+                     << "\t" << max_bytes << "\t\t" << us << "\t\t" << bw << "\n";
+                csv << N << "," << world_size << "," << v.name << ","
+                    << max_bytes << "," << us << "," << bw << "\n";
+            }
+        }
+        if (rank == 0) cout << "\n";
+    }
+
+    if (rank == 0) {
+        csv.close();
+        cout << "=================================================================\n";
+        cout << "Results saved to: halo_benchmark_results.csv\n";
+    }
+}
+
 int main(int argc, char** argv) {
     MPI_Init(&argc, &argv);
     
@@ -66,7 +297,19 @@ int main(int argc, char** argv) {
         MPI_Finalize();
         return 1;
     }
-    
+
+    // 'halo' mode: benchmark the 2D neighbor-exchange shapes from
+    // sobel_mpi.cpp instead of simple ping-pong. Optional trailing arguments
+    // select the image sizes to model.
+    if (argc > 1 && string(argv[1]) == "halo") {
+        vector<int> image_sizes;
+        for (int a = 2; a < argc; ++a) image_sizes.push_back(atoi(argv[a]));
+        if (image_sizes.empty()) image_sizes = {512, 1024, 2048, 4096};
+        run_halo_suite(rank, world_size, image_sizes);
+        MPI_Finalize();
+        return 0;
+    }
+
     if (rank == 0) {
         cout << "MPI Latency and Bandwidth Benchmark\n";
         cout << "===================================\n";
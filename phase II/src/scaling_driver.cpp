@@ -0,0 +1,253 @@
+// End-to-end scaling benchmark driver
+//
+// A full scaling study used to mean running Phase1/benchmark.sh, the phase II
+// run_scripts and hand-editing the CSVs together - with the two binaries
+// speaking different output dialects (MODE=... vs RANKS=...). This driver
+// runs the whole matrix from one command: the Phase 1 seq/omp thread sweep,
+// the sobel_mpi rank sweep, and the latency suite, parsing each binary's
+// KEY=VALUE stdout and computing speedup, efficiency and the Karp-Flatt
+// serial-fraction metric in-process (no bc, no awk). One unified table is
+// written to scaling_results.csv, and the two analyzer-native views -
+// ../Phase1/benchmark_results.csv for analyze_performance.py and
+// strong_scaling_results.csv for analyze_mpi.py - are derived from that same
+// table, so both analyzers work untouched off a single run.
+//
+// Run from the phase II directory (it reaches the Phase 1 binaries via
+// ../Phase1). Build: 'make driver'; run: 'make benchmark-scaling' or
+//   ./src/scaling_driver [num_runs]
+// Extra mpirun flags (e.g. --oversubscribe) are taken from $MPIRUN_FLAGS.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include <iomanip>
+#include <algorithm>
+#include <sys/stat.h>
+
+using namespace std;
+
+// One row of the unified table; WORKERS is threads for the omp suite and
+// ranks for the mpi suite
+struct ScalingRow {
+    string suite;        // "omp" or "mpi"
+    int image_size;
+    string mode;         // SEQ / OMP / MPI
+    int workers;
+    double avg_ms, min_ms, max_ms, gflops;
+    double speedup, efficiency, karp_flatt;  // karp_flatt < 0 = undefined
+};
+
+// Run a command and capture its combined stdout+stderr
+string run_capture(const string &cmd) {
+    FILE *p = popen((cmd + " 2>&1").c_str(), "r");
+    if (!p) return "";
+    string out;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), p)) > 0)
+        out.append(buf, n);
+    pclose(p);
+    return out;
+}
+
+// Extract "KEY=<number>" from a binary's output line; -1 if absent. The key
+// must start a line or follow whitespace so AVG_TIME doesn't match TIME.
+double parse_field(const string &text, const string &key) {
+    string needle = key + "=";
+    size_t pos = 0;
+    while ((pos = text.find(needle, pos)) != string::npos) {
+        if (pos == 0 || isspace((unsigned char)text[pos - 1]))
+            return atof(text.c_str() + pos + needle.size());
+        pos += needle.size();
+    }
+    return -1;
+}
+
+bool file_exists(const string &path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0;
+}
+
+// Karp-Flatt experimentally determined serial fraction:
+//   e = (1/S - 1/p) / (1 - 1/p)
+// A flat e across p means the serial fraction limits scaling (Amdahl); an e
+// that grows with p points at communication/synchronization overhead instead.
+double karp_flatt(double speedup, int p) {
+    if (p <= 1 || speedup <= 0) return -1;
+    return (1.0 / speedup - 1.0 / p) / (1.0 - 1.0 / p);
+}
+
+int main(int argc, char **argv) {
+    int num_runs = (argc > 1) ? atoi(argv[1]) : 5;
+    if (num_runs < 1) {
+        cerr << "Usage: ./src/scaling_driver [num_runs]\n";
+        return 1;
+    }
+
+    // Same matrix as the scripts this replaces
+    vector<int> sizes = { 1024, 2048 };
+    vector<int> workers = { 1, 2, 4, 8 };
+
+    const string phase1 = "../Phase1";
+    const char *env_flags = getenv("MPIRUN_FLAGS");
+    string mpirun = string("mpirun ") + (env_flags ? env_flags : "");
+
+    // All four binaries up front, with the make target that builds each
+    struct { string path, hint; } needed[] = {
+        { phase1 + "/edge_sobel_seq", "'make all' in Phase1" },
+        { phase1 + "/edge_sobel_omp", "'make all' in Phase1" },
+        { "src/sobel_mpi",            "'make sobel'" },
+        { "src/benchmark_latency",    "'make latency'" },
+    };
+    for (auto &b : needed) {
+        if (!file_exists(b.path)) {
+            cerr << "Error: " << b.path << " not found. Run " << b.hint
+                 << " first.\n";
+            return 1;
+        }
+    }
+
+    cout << "===================================================================\n";
+    cout << "Unified Scaling Benchmark (Phase 1 + Phase 2)\n";
+    cout << "===================================================================\n\n";
+
+    vector<ScalingRow> rows;
+
+    // --- Suite 1: Phase 1 OpenMP thread sweep -------------------------------
+    for (int size : sizes) {
+        cout << "--- OpenMP sweep, N=" << size << " ---\n";
+        ostringstream seq_cmd;
+        seq_cmd << phase1 << "/edge_sobel_seq seq " << size << " 1 " << num_runs;
+        string out = run_capture(seq_cmd.str());
+        double base = parse_field(out, "AVG_TIME");
+        if (base <= 0) {
+            cerr << "Error: no AVG_TIME from '" << seq_cmd.str() << "'\n";
+            return 1;
+        }
+        rows.push_back({ "omp", size, "SEQ", 1, base,
+                         parse_field(out, "MIN"), parse_field(out, "MAX"),
+                         parse_field(out, "GFLOPS"), 1.0, 1.0, -1 });
+        cout << "  seq: " << base << " ms\n";
+
+        for (int t : workers) {
+            ostringstream cmd;
+            cmd << phase1 << "/edge_sobel_omp omp " << size << " " << t
+                << " " << num_runs;
+            out = run_capture(cmd.str());
+            double avg = parse_field(out, "AVG_TIME");
+            if (avg <= 0) {
+                cerr << "Error: no AVG_TIME from '" << cmd.str() << "'\n";
+                return 1;
+            }
+            double s = base / avg;
+            rows.push_back({ "omp", size, "OMP", t, avg,
+                             parse_field(out, "MIN"), parse_field(out, "MAX"),
+                             parse_field(out, "GFLOPS"),
+                             s, s / t, karp_flatt(s, t) });
+            cout << "  omp " << t << " threads: " << avg << " ms ("
+                 << fixed << setprecision(2) << s << "x)\n"
+                 << defaultfloat;
+        }
+    }
+    cout << "\n";
+
+    // --- Suite 2: MPI rank sweep --------------------------------------------
+    for (int size : sizes) {
+        cout << "--- MPI sweep, N=" << size << " ---\n";
+        double base = 0;
+        for (int p : workers) {
+            ostringstream cmd;
+            cmd << mpirun << " -np " << p << " src/sobel_mpi " << size
+                << " " << num_runs;
+            string out = run_capture(cmd.str());
+            double avg = parse_field(out, "AVG_TIME");
+            if (avg <= 0) {
+                cerr << "Error: no AVG_TIME from '" << cmd.str() << "'\n";
+                return 1;
+            }
+            if (p == 1) base = avg;
+            double s = (base > 0) ? base / avg : 0;
+            // sobel_mpi reports no MIN/MAX; 0 matches what the old shell
+            // scripts recorded for those columns
+            double mn = max(parse_field(out, "MIN"), 0.0);
+            double mx = max(parse_field(out, "MAX"), 0.0);
+            rows.push_back({ "mpi", size, "MPI", p, avg, mn, mx,
+                             -1, s, s / p, karp_flatt(s, p) });
+            cout << "  " << p << " ranks: " << avg << " ms ("
+                 << fixed << setprecision(2) << s << "x)\n"
+                 << defaultfloat;
+        }
+    }
+    cout << "\n";
+
+    // --- Suite 3: latency suite ---------------------------------------------
+    // The latency binary already writes its own analyzer inputs: the
+    // ping-pong table (captured here into latency_bandwidth_results.txt)
+    // and halo_benchmark_results.csv from the halo mode.
+    cout << "--- Latency suite ---\n";
+    string lat = run_capture(mpirun + " -np 2 src/benchmark_latency");
+    ofstream lat_file("latency_bandwidth_results.txt");
+    lat_file << lat;
+    lat_file.close();
+    cout << "  ping-pong table -> latency_bandwidth_results.txt\n";
+    run_capture(mpirun + " -np 4 src/benchmark_latency halo");
+    cout << "  halo suite -> halo_benchmark_results.csv\n\n";
+
+    // --- Unified table ------------------------------------------------------
+    ofstream uni("scaling_results.csv");
+    uni << "SUITE,IMAGE_SIZE,MODE,WORKERS,AVG_TIME_MS,MIN_TIME_MS,MAX_TIME_MS,"
+           "GFLOPS,SPEEDUP,EFFICIENCY,KARP_FLATT\n";
+    uni << fixed << setprecision(3);
+    for (const ScalingRow &r : rows) {
+        uni << r.suite << "," << r.image_size << "," << r.mode << ","
+            << r.workers << "," << r.avg_ms << "," << r.min_ms << ","
+            << r.max_ms << ",";
+        if (r.gflops >= 0) uni << r.gflops;
+        uni << "," << r.speedup << "," << r.efficiency << ",";
+        if (r.karp_flatt >= 0) uni << r.karp_flatt;
+        uni << "\n";
+    }
+    uni.close();
+
+    // --- Analyzer-native views, derived from the same table -----------------
+    // analyze_performance.py reads Phase1/benchmark_results.csv
+    ofstream p1(phase1 + "/benchmark_results.csv");
+    p1 << "IMAGE_SIZE,MODE,THREADS,TILE,AVG_TIME_MS,MIN_TIME_MS,MAX_TIME_MS,"
+          "GFLOPS,XFER_MS,SKIP\n";
+    p1 << fixed << setprecision(3);
+    for (const ScalingRow &r : rows) {
+        if (r.suite != "omp") continue;
+        p1 << r.image_size << "," << r.mode << "," << r.workers << ",,"
+           << r.avg_ms << "," << r.min_ms << "," << r.max_ms << ","
+           << r.gflops << ",,\n";
+    }
+    p1.close();
+
+    // analyze_mpi.py reads strong_scaling_results.csv
+    ofstream p2("strong_scaling_results.csv");
+    p2 << "IMAGE_SIZE,PROCESSES,AVG_TIME_MS,MIN_TIME_MS,MAX_TIME_MS,"
+          "SPEEDUP,EFFICIENCY\n";
+    p2 << fixed << setprecision(3);
+    for (const ScalingRow &r : rows) {
+        if (r.suite != "mpi") continue;
+        p2 << r.image_size << "," << r.workers << "," << r.avg_ms << ","
+           << r.min_ms << "," << r.max_ms << "," << r.speedup << ","
+           << r.efficiency << "\n";
+    }
+    p2.close();
+
+    cout << "===================================================================\n";
+    cout << "Scaling study complete!\n";
+    cout << "  scaling_results.csv            - unified table (all suites)\n";
+    cout << "  ../Phase1/benchmark_results.csv - view for analyze_performance.py\n";
+    cout << "  strong_scaling_results.csv     - view for analyze_mpi.py\n";
+    cout << "\nAnalyze results:\n";
+    cout << "  (cd ../Phase1 && python3 analyze_performance.py)\n";
+    cout << "  python3 analyze_mpi.py\n";
+    return 0;
+}
@@ -1,80 +1,143 @@
 """
 Sobel edge detection worker module.
-Implements the actual Sobel algorithm in Python.
+Calls the native libsobel C library in-process via ctypes when available,
+falling back to a pure-Python implementation otherwise.
 """
 
+import ctypes
+import os
 import numpy as np
-from typing import Tuple
+from typing import Optional, Tuple
 
-def sobel_edge_detection(image: np.ndarray) -> np.ndarray:
+# Candidate locations for libsobel.so (built with 'make lib' in Phase1).
+# SOBEL_LIB overrides; the relative path covers running from the repo checkout.
+_LIB_CANDIDATES = [
+    os.environ.get("SOBEL_LIB", ""),
+    os.path.join(os.path.dirname(__file__), "..", "..", "Phase1", "libsobel.so"),
+    "libsobel.so",
+]
+
+_lib = None
+_lib_checked = False
+
+
+def _load_library() -> Optional[ctypes.CDLL]:
+    """Load libsobel.so once; return None if no candidate path works."""
+    global _lib, _lib_checked
+    if _lib_checked:
+        return _lib
+    _lib_checked = True
+
+    for path in _LIB_CANDIDATES:
+        if not path:
+            continue
+        try:
+            lib = ctypes.CDLL(path)
+        except OSError:
+            continue
+        lib.sobel_process.argtypes = [
+            ctypes.POINTER(ctypes.c_uint8),  # input
+            ctypes.POINTER(ctypes.c_uint8),  # output
+            ctypes.c_int,                    # rows
+            ctypes.c_int,                    # cols
+            ctypes.c_char_p,                 # variant
+            ctypes.c_int,                    # threads
+        ]
+        lib.sobel_process.restype = ctypes.c_int
+        lib.sobel_variants.restype = ctypes.c_char_p
+        _lib = lib
+        break
+    return _lib
+
+
+def native_available() -> bool:
+    """True if the libsobel native path is usable."""
+    return _load_library() is not None
+
+
+def sobel_edge_detection(image: np.ndarray, variant: str = "omp",
+                         threads: int = 0) -> np.ndarray:
     """
     Apply Sobel edge detection to a grayscale image.
-    
+
+    Uses libsobel in-process when available: the numpy buffers are passed
+    to the C kernels directly (zero copies, no subprocess). Edge magnitudes
+    are clamped to 255 and the one-pixel border is 0, matching the Phase 1
+    binaries. The pure-Python fallback mirrors that convention.
+
     Args:
         image: 2D numpy array of grayscale pixel values (0-255)
-    
+        variant: native kernel to run ("seq", "omp" or "tiled")
+        threads: OpenMP thread count for parallel variants (0 = default)
+
     Returns:
         2D numpy array of edge magnitudes (0-255)
     """
     height, width = image.shape
-    
+
+    lib = _load_library()
+    if lib is not None and height >= 3 and width >= 3:
+        src = np.ascontiguousarray(image, dtype=np.uint8)
+        result = np.empty((height, width), dtype=np.uint8)
+        status = lib.sobel_process(
+            src.ctypes.data_as(ctypes.POINTER(ctypes.c_uint8)),
+            result.ctypes.data_as(ctypes.POINTER(ctypes.c_uint8)),
+            height, width, variant.encode(), threads)
+        if status == 0:
+            return result
+        # Unknown variant or bad arguments: fall through to Python
+
+    return _sobel_python(image)
+
+
+def _sobel_python(image: np.ndarray) -> np.ndarray:
+    """Pure-Python fallback, same border and clamping convention as libsobel."""
+    height, width = image.shape
+
     # Sobel kernels
     sobel_x = np.array([[-1, 0, 1],
                         [-2, 0, 2],
                         [-1, 0, 1]], dtype=np.float32)
-    
+
     sobel_y = np.array([[-1, -2, -1],
                         [ 0,  0,  0],
                         [ 1,  2,  1]], dtype=np.float32)
-    
-    # Pad image for border handling
-    padded = np.pad(image, pad_width=1, mode='edge')
-    
-    # Output array
-    result = np.zeros((height, width), dtype=np.float32)
-    
-    # Apply Sobel operator
-    for i in range(height):
-        for j in range(width):
-            # Extract 3x3 neighborhood
-            region = padded[i:i+3, j:j+3].astype(np.float32)
-            
-            # Compute gradients
+
+    result = np.zeros((height, width), dtype=np.uint8)
+
+    # Apply Sobel operator (interior only; border stays 0)
+    for i in range(1, height - 1):
+        for j in range(1, width - 1):
+            region = image[i-1:i+2, j-1:j+2].astype(np.float32)
+
             gx = np.sum(region * sobel_x)
             gy = np.sum(region * sobel_y)
-            
-            # Compute magnitude
+
             magnitude = np.sqrt(gx**2 + gy**2)
-            result[i, j] = magnitude
-    
-    # Normalize to 0-255
-    if result.max() > 0:
-        result = (result / result.max() * 255).astype(np.uint8)
-    else:
-        result = result.astype(np.uint8)
-    
+            result[i, j] = min(int(magnitude), 255)
+
     return result
 
 
 def process_image_bytes(image_bytes: bytes, width: int, height: int) -> bytes:
     """
     Process raw image bytes and return edge-detected result.
-    
+
     Args:
         image_bytes: Flattened grayscale image data
         width: Image width
         height: Image height
-    
+
     Returns:
         Edge-detected image as bytes
     """
     # Convert bytes to numpy array
     image_array = np.frombuffer(image_bytes, dtype=np.uint8)
     image_2d = image_array.reshape((height, width))
-    
+
     # Apply Sobel
     result = sobel_edge_detection(image_2d)
-    
+
     # Convert back to bytes
     return result.tobytes()
 
@@ -82,16 +145,23 @@ def process_image_bytes(image_bytes: bytes, width: int, height: int) -> bytes:
 if __name__ == "__main__":
     # Test with a simple gradient image
     print("Testing Sobel edge detection...")
-    
+    print(f"Native libsobel: {'loaded' if native_available() else 'not found (Python fallback)'}")
+
     # Create test image (64x64 gradient)
     test_img = np.zeros((64, 64), dtype=np.uint8)
     for i in range(64):
         test_img[i, :] = i * 4  # Vertical gradient
-    
+
     # Apply Sobel
     edges = sobel_edge_detection(test_img)
-    
+
     print(f"Input shape: {test_img.shape}")
     print(f"Output shape: {edges.shape}")
     print(f"Output range: [{edges.min()}, {edges.max()}]")
+
+    if native_available():
+        # Native and Python paths must agree exactly
+        assert np.array_equal(edges, _sobel_python(test_img)), \
+            "native/python mismatch"
+        print("Native path matches Python fallback")
     print("Test passed!")